@@ -0,0 +1,301 @@
+#ifndef MESH_GRAPH_DEFINED_H
+#define MESH_GRAPH_DEFINED_H
+#include <vector>
+#include <queue>
+#include <thread>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+#include <string>
+
+#include "TwoDHalfEdgeGeometry.h"
+
+/* Algoritmos de grafo sobre a malha: componentes conexas, BFS/flood fill no
+dual das faces e caminhos mínimos ao longo das arestas.
+
+O construtor tira um retrato da conectividade em vetores compactos (CSR):
+vizinhos de cada vértice (com o ID da half-edge e o comprimento da aresta) e
+faces vizinhas de cada face. Os algoritmos trabalham só sobre esses vetores,
+sem passar pelas tabelas de ponteiros da TwoDHalfEdgeGeometry. O retrato não
+acompanha mudanças posteriores na geometria.
+*/
+class MeshGraph
+{
+public:
+    struct path_result
+    {
+        bool found;
+        double length;
+        std::vector<unsigned int> vertices; // do início ao fim
+        std::vector<unsigned int> edges;    // half-edges percorridas, na ordem
+    };
+
+private:
+    // Fronteiras menores que isso são processadas sem criar threads.
+    static const size_t PARALLEL_THRESHOLD = 4096;
+
+    unsigned int n_vxs, n_fas, n_threads;
+    std::vector<double> vx_x, vx_y;
+
+    std::vector<size_t> vx_offsets;       // vizinhos do vértice v: [vx_offsets[v], vx_offsets[v+1])
+    std::vector<unsigned int> vx_adj;     // vértice de destino
+    std::vector<unsigned int> vx_adj_he;  // half-edge que leva até ele
+    std::vector<double> vx_adj_len;       // comprimento da aresta
+
+    std::vector<size_t> fa_offsets;       // faces vizinhas da face f: [fa_offsets[f], fa_offsets[f+1])
+    std::vector<unsigned int> fa_adj;
+
+    /* Divide [0, n) em blocos e chama 'body(inicio, fim, thread)' para cada
+    bloco, um por thread. Abaixo de PARALLEL_THRESHOLD roda na thread atual.
+    */
+    template <typename Body>
+    void parallel_for(size_t n, Body body) const
+    {
+        unsigned int threads = n < PARALLEL_THRESHOLD ? 1 : n_threads;
+        if (threads <= 1) { body(0, n, 0u); return; }
+
+        std::vector<std::thread> pool;
+        size_t chunk = (n + threads - 1) / threads;
+        for (unsigned int t = 1; t < threads; ++t) {
+            size_t begin = std::min(n, t * chunk), end = std::min(n, begin + chunk);
+            pool.emplace_back(body, begin, end, t);
+        }
+        body(0, std::min(n, chunk), 0u);
+        for (auto& th : pool) th.join();
+    }
+
+    void check_vertex(unsigned int vx_id) const
+    {
+        if (vx_id >= n_vxs) throw std::out_of_range("Vertice " + std::to_string(vx_id) + " inexistente.");
+    }
+
+    void check_face(unsigned int fa_id) const
+    {
+        if (fa_id >= n_fas) throw std::out_of_range("Face " + std::to_string(fa_id) + " inexistente.");
+    }
+
+    /* Dijkstra, ou A* com a distância euclidiana até o destino como heurística
+    (admissível, pois nenhum caminho pelas arestas é mais curto que a reta).
+    */
+    path_result shortest_path(unsigned int src, unsigned int dst, bool use_heuristic) const
+    {
+        check_vertex(src);
+        check_vertex(dst);
+
+        const double inf = std::numeric_limits<double>::infinity();
+        std::vector<double> dist(n_vxs, inf);
+        std::vector<size_t> came_by(n_vxs, (size_t)-1); // posição em vx_adj usada para chegar
+        std::vector<bool> done(n_vxs, false);
+
+        auto heuristic = [&](unsigned int v) {
+            return use_heuristic ? std::hypot(vx_x[v] - vx_x[dst], vx_y[v] - vx_y[dst]) : 0.0;
+        };
+
+        typedef std::pair<double, unsigned int> queue_item; // (prioridade, vértice)
+        std::priority_queue<queue_item, std::vector<queue_item>, std::greater<queue_item>> open;
+        dist[src] = 0.0;
+        open.push({heuristic(src), src});
+
+        while (!open.empty()) {
+            unsigned int u = open.top().second;
+            open.pop();
+            if (done[u]) continue;
+            done[u] = true;
+            if (u == dst) break;
+
+            for (size_t i = vx_offsets[u]; i < vx_offsets[u + 1]; ++i) {
+                unsigned int v = vx_adj[i];
+                double nd = dist[u] + vx_adj_len[i];
+                if (nd < dist[v]) {
+                    dist[v] = nd;
+                    came_by[v] = i;
+                    open.push({nd + heuristic(v), v});
+                }
+            }
+        }
+
+        path_result result{dist[dst] != inf, dist[dst], {}, {}};
+        if (!result.found) return result;
+
+        // Reconstrói o caminho de trás para frente.
+        unsigned int v = dst;
+        result.vertices.push_back(v);
+        while (v != src) {
+            size_t i = came_by[v];
+            result.edges.push_back(vx_adj_he[i]);
+            v = (unsigned int)(std::upper_bound(vx_offsets.begin(), vx_offsets.end(), i) - vx_offsets.begin() - 1);
+            result.vertices.push_back(v);
+        }
+        std::reverse(result.vertices.begin(), result.vertices.end());
+        std::reverse(result.edges.begin(), result.edges.end());
+        return result;
+    }
+
+public:
+    /* 'max_threads' limita as threads dos algoritmos paralelos (0 = número de núcleos).
+    Uma geometria no modo preguiçoso é construída por inteiro aqui.
+    */
+    explicit MeshGraph(TwoDHalfEdgeGeometry& geometry, unsigned int max_threads = 0)
+    {
+        n_vxs = geometry.get_vertex_count();
+        n_fas = geometry.get_face_count();
+        n_threads = max_threads ? max_threads : std::max(1u, std::thread::hardware_concurrency());
+
+        vx_x.resize(n_vxs);
+        vx_y.resize(n_vxs);
+        for (unsigned int v = 0; v < n_vxs; ++v) {
+            auto pos = geometry.get_vertex_position(v);
+            vx_x[v] = pos.first;
+            vx_y[v] = pos.second;
+        }
+
+        // 1. Conta os graus para dimensionar os vetores CSR.
+        vx_offsets.assign(n_vxs + 1, 0);
+        fa_offsets.assign(n_fas + 1, 0);
+        geometry.for_each_half_edge([&](unsigned int, unsigned int origin, unsigned int, long fa, long twin_fa) {
+            vx_offsets[origin + 1]++;
+            if (fa >= 0 && twin_fa >= 0) fa_offsets[fa + 1]++;
+        });
+        for (unsigned int v = 0; v < n_vxs; ++v) vx_offsets[v + 1] += vx_offsets[v];
+        for (unsigned int f = 0; f < n_fas; ++f) fa_offsets[f + 1] += fa_offsets[f];
+
+        // 2. Preenche os vizinhos.
+        vx_adj.resize(vx_offsets[n_vxs]);
+        vx_adj_he.resize(vx_offsets[n_vxs]);
+        vx_adj_len.resize(vx_offsets[n_vxs]);
+        fa_adj.resize(fa_offsets[n_fas]);
+        std::vector<size_t> vx_fill(vx_offsets.begin(), vx_offsets.end() - 1);
+        std::vector<size_t> fa_fill(fa_offsets.begin(), fa_offsets.end() - 1);
+        geometry.for_each_half_edge([&](unsigned int he_id, unsigned int origin, unsigned int dest, long fa, long twin_fa) {
+            size_t i = vx_fill[origin]++;
+            vx_adj[i] = dest;
+            vx_adj_he[i] = he_id;
+            vx_adj_len[i] = std::hypot(vx_x[dest] - vx_x[origin], vx_y[dest] - vx_y[origin]);
+            if (fa >= 0 && twin_fa >= 0) fa_adj[fa_fill[fa]++] = (unsigned int)twin_fa;
+        });
+    }
+
+    unsigned int get_vertex_count() const { return n_vxs; }
+    unsigned int get_face_count() const { return n_fas; }
+
+    /* Componentes conexas do grafo de vértices e arestas, por union-find paralelo
+    sem locks: cada thread une as arestas do seu bloco, sempre pendurando a raiz
+    de maior ID na de menor ID. Assim a raiz de cada componente é o menor ID de
+    vértice dela, que é gravado em 'labels'. Retorna o número de componentes.
+    */
+    unsigned int connected_components(std::vector<unsigned int>& labels) const
+    {
+        std::vector<std::atomic<unsigned int>> parent(n_vxs);
+        parallel_for(n_vxs, [&](size_t begin, size_t end, unsigned int) {
+            for (size_t v = begin; v < end; ++v) parent[v].store((unsigned int)v, std::memory_order_relaxed);
+        });
+
+        auto find = [&](unsigned int x) {
+            unsigned int p = parent[x].load(std::memory_order_relaxed);
+            while (p != x) {
+                // Compressão por halving; uma falha do CAS só significa que outra thread já encurtou.
+                unsigned int gp = parent[p].load(std::memory_order_relaxed);
+                parent[x].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+                x = p;
+                p = parent[x].load(std::memory_order_relaxed);
+            }
+            return x;
+        };
+
+        parallel_for(n_vxs, [&](size_t begin, size_t end, unsigned int) {
+            for (size_t u = begin; u < end; ++u) {
+                for (size_t i = vx_offsets[u]; i < vx_offsets[u + 1]; ++i) {
+                    if (vx_adj[i] < u) continue; // Cada aresta aparece nos dois sentidos.
+                    unsigned int a = find((unsigned int)u), b = find(vx_adj[i]);
+                    while (a != b) {
+                        if (a < b) std::swap(a, b);
+                        unsigned int expected = a;
+                        if (parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed)) break;
+                        a = find(a);
+                        b = find(b);
+                    }
+                }
+            }
+        });
+
+        labels.resize(n_vxs);
+        std::vector<unsigned int> roots_per_thread(n_threads, 0);
+        parallel_for(n_vxs, [&](size_t begin, size_t end, unsigned int t) {
+            for (size_t v = begin; v < end; ++v) {
+                labels[v] = find((unsigned int)v);
+                if (labels[v] == v) roots_per_thread[t]++;
+            }
+        });
+
+        unsigned int n_components = 0;
+        for (unsigned int c : roots_per_thread) n_components += c;
+        return n_components;
+    }
+
+    /* BFS no dual das faces (faces vizinhas compartilham uma aresta), por
+    fronteiras: cada nível é dividido entre as threads, que disputam as faces
+    ainda não visitadas com compare-and-swap. Retorna a distância, em saltos,
+    de cada face até 'start_fa' (-1 se inalcançável ou além de 'max_depth').
+    */
+    std::vector<int> face_bfs(unsigned int start_fa, int max_depth = -1) const
+    {
+        check_face(start_fa);
+
+        std::vector<std::atomic<int>> dist(n_fas);
+        parallel_for(n_fas, [&](size_t begin, size_t end, unsigned int) {
+            for (size_t f = begin; f < end; ++f) dist[f].store(-1, std::memory_order_relaxed);
+        });
+        dist[start_fa].store(0, std::memory_order_relaxed);
+
+        std::vector<unsigned int> frontier{start_fa};
+        std::vector<std::vector<unsigned int>> next_local(n_threads);
+        for (int level = 0; !frontier.empty() && level != max_depth; ++level) {
+            parallel_for(frontier.size(), [&](size_t begin, size_t end, unsigned int t) {
+                std::vector<unsigned int>& next = next_local[t];
+                for (size_t i = begin; i < end; ++i) {
+                    unsigned int f = frontier[i];
+                    for (size_t j = fa_offsets[f]; j < fa_offsets[f + 1]; ++j) {
+                        int expected = -1;
+                        if (dist[fa_adj[j]].load(std::memory_order_relaxed) == -1 &&
+                            dist[fa_adj[j]].compare_exchange_strong(expected, level + 1, std::memory_order_relaxed)) {
+                            next.push_back(fa_adj[j]);
+                        }
+                    }
+                }
+            });
+
+            frontier.clear();
+            for (auto& next : next_local) {
+                frontier.insert(frontier.end(), next.begin(), next.end());
+                next.clear();
+            }
+        }
+
+        std::vector<int> result(n_fas);
+        parallel_for(n_fas, [&](size_t begin, size_t end, unsigned int) {
+            for (size_t f = begin; f < end; ++f) result[f] = dist[f].load(std::memory_order_relaxed);
+        });
+        return result;
+    }
+
+    /* Retorna, em ordem crescente, os IDs das faces alcançáveis a partir de 'start_fa'. */
+    std::vector<unsigned int> flood_fill(unsigned int start_fa) const
+    {
+        std::vector<int> dist = face_bfs(start_fa);
+        std::vector<unsigned int> region;
+        for (unsigned int f = 0; f < n_fas; ++f) {
+            if (dist[f] >= 0) region.push_back(f);
+        }
+        return region;
+    }
+
+    /* Caminho mínimo entre dois vértices, com as arestas pesadas pelo comprimento. */
+    path_result dijkstra(unsigned int src_vx, unsigned int dst_vx) const { return shortest_path(src_vx, dst_vx, false); }
+
+    /* Mesmo resultado que dijkstra(), visitando menos vértices. */
+    path_result a_star(unsigned int src_vx, unsigned int dst_vx) const { return shortest_path(src_vx, dst_vx, true); }
+};
+
+#endif
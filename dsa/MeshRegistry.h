@@ -0,0 +1,222 @@
+#ifndef MESH_REGISTRY_DEFINED_H
+#define MESH_REGISTRY_DEFINED_H
+#include <vector>
+#include <map>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <stdexcept>
+#include <algorithm>
+
+#include "TwoDHalfEdgeGeometry.h"
+
+// Implementado em io/objreader.cpp
+bool read_obj_file(const std::string& filepath, std::vector<double>& vxs_pos, std::map<int, std::vector<int>>& fa_vxs);
+
+/* Registro de várias malhas carregadas na mesma sessão.
+
+Cada arquivo recebe um ID (sua posição na ordem de carregamento). As malhas são
+carregadas em paralelo por um número limitado de threads e, quando a memória
+total ultrapassa o orçamento configurado, as malhas usadas há mais tempo são
+descarregadas. Uma malha descarregada é lida novamente do disco ao ser selecionada.
+*/
+class MeshRegistry
+{
+private:
+    struct mesh_entry
+    {
+        std::string path;
+        std::shared_ptr<TwoDHalfEdgeGeometry> geometry;
+        size_t bytes;
+        unsigned long last_use;
+        std::string error;
+    };
+
+    std::vector<mesh_entry> meshes;
+    size_t mem_budget;   // 0 = sem limite
+    size_t total_bytes;
+    unsigned long use_ctr;
+    int selected_id;
+    bool lazy;
+    mutable std::mutex mtx;
+
+    /* Guarda uma geometria recém-construída. Chamar com o lock adquirido. */
+    void store(unsigned int mesh_id, std::shared_ptr<TwoDHalfEdgeGeometry> geometry, const std::string& error)
+    {
+        mesh_entry& entry = meshes[mesh_id];
+        if (entry.geometry) total_bytes -= entry.bytes;
+        entry.geometry = geometry;
+        entry.error = error;
+        entry.bytes = geometry ? geometry->memory_usage() : 0;
+        entry.last_use = ++use_ctr;
+        total_bytes += entry.bytes;
+        evict_over_budget(mesh_id);
+    }
+
+    /* Descarrega as malhas menos usadas recentemente até caber no orçamento.
+    Nunca descarta a malha selecionada nem a indicada em 'keep_id'. Chamar com o lock adquirido.
+    */
+    void evict_over_budget(unsigned int keep_id)
+    {
+        while (mem_budget != 0 && total_bytes > mem_budget)
+        {
+            int lru_id = -1;
+            for (size_t i = 0; i < meshes.size(); ++i) {
+                if (!meshes[i].geometry || i == keep_id || (int)i == selected_id) continue;
+                if (lru_id < 0 || meshes[i].last_use < meshes[lru_id].last_use) lru_id = (int)i;
+            }
+            if (lru_id < 0) break; // Só sobraram malhas protegidas.
+
+            total_bytes -= meshes[lru_id].bytes;
+            meshes[lru_id].bytes = 0;
+            // Quem ainda segura o shared_ptr mantém a geometria viva até soltá-lo.
+            meshes[lru_id].geometry.reset();
+        }
+    }
+
+public:
+    /* Lê e constrói a geometria de um arquivo, sem passar pelo registro (não usa o lock).
+    Erros (inclusive as exceções de linhas malformadas no leitor) vão para 'error'
+    e o retorno é nullptr.
+    */
+    static std::shared_ptr<TwoDHalfEdgeGeometry> build_from_file(const std::string& path, bool lazy, std::string& error)
+    {
+        std::vector<double> vertex_positions;
+        std::map<int, std::vector<int>> face_vertices;
+        try {
+            if (!read_obj_file(path, vertex_positions, face_vertices)) {
+                error = "Nao foi possivel ler o arquivo.";
+                return nullptr;
+            }
+            return std::make_shared<TwoDHalfEdgeGeometry>(vertex_positions, face_vertices, lazy);
+        } catch (const std::exception& e) {
+            error = e.what();
+            return nullptr;
+        }
+    }
+
+    /* 'lazy' = true cria as geometrias no modo preguiçoso (veja TwoDHalfEdgeGeometry). */
+    MeshRegistry(size_t memory_budget_bytes = 0, bool lazy = false)
+        : mem_budget(memory_budget_bytes), total_bytes(0), use_ctr(0), selected_id(-1), lazy(lazy) {}
+
+    /* Carrega vários arquivos em paralelo, usando no máximo 'max_threads' threads
+    (0 = número de núcleos). Retorna os IDs atribuídos, na mesma ordem de 'paths'.
+    Falhas de leitura não interrompem as outras cargas; veja is_loaded()/get_error().
+    */
+    std::vector<unsigned int> load_files(const std::vector<std::string>& paths, unsigned int max_threads = 0)
+    {
+        std::vector<unsigned int> ids;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            for (const auto& path : paths) {
+                ids.push_back((unsigned int)meshes.size());
+                meshes.push_back({path, nullptr, 0, 0, ""});
+            }
+        }
+        if (paths.empty()) return ids;
+
+        if (max_threads == 0) max_threads = std::max(1u, std::thread::hardware_concurrency());
+        unsigned int n_threads = std::min<unsigned int>(max_threads, (unsigned int)paths.size());
+
+        std::atomic<size_t> next(0);
+        auto worker = [&]() {
+            for (size_t i = next++; i < paths.size(); i = next++) {
+                std::string error;
+                auto geometry = build_from_file(paths[i], lazy, error);
+                std::lock_guard<std::mutex> lock(mtx);
+                store(ids[i], geometry, error);
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned int t = 1; t < n_threads; ++t) pool.emplace_back(worker);
+        worker();
+        for (auto& th : pool) th.join();
+        return ids;
+    }
+
+    /* Seleciona uma malha e a marca como usada, recarregando-a do disco se
+    tiver sido descarregada. Lança out_of_range para IDs inexistentes e
+    runtime_error se a malha não puder ser carregada.
+    */
+    std::shared_ptr<TwoDHalfEdgeGeometry> select(unsigned int mesh_id)
+    {
+        std::string path;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            mesh_entry& entry = meshes.at(mesh_id);
+            if (entry.geometry) {
+                selected_id = (int)mesh_id;
+                // No modo preguiçoso a malha cresce conforme é consultada.
+                store(mesh_id, entry.geometry, entry.error);
+                return entry.geometry;
+            }
+            path = entry.path;
+        }
+
+        std::string error;
+        auto geometry = build_from_file(path, lazy, error);
+
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!geometry) {
+            store(mesh_id, geometry, error);
+            throw std::runtime_error("Malha " + std::to_string(mesh_id) + ": " + error);
+        }
+        // Seleciona antes de guardar, para que a malha anterior deixe de ser protegida da remoção.
+        selected_id = (int)mesh_id;
+        store(mesh_id, geometry, error);
+        return geometry;
+    }
+
+    /* Retorna a malha selecionada, ou nullptr se nenhuma foi selecionada. */
+    std::shared_ptr<TwoDHalfEdgeGeometry> get_selected() const
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        return selected_id < 0 ? nullptr : meshes[selected_id].geometry;
+    }
+
+    int get_selected_id() const { std::lock_guard<std::mutex> lock(mtx); return selected_id; }
+
+    size_t size() const { std::lock_guard<std::mutex> lock(mtx); return meshes.size(); }
+
+    std::string get_path(unsigned int mesh_id) const { std::lock_guard<std::mutex> lock(mtx); return meshes.at(mesh_id).path; }
+
+    bool is_loaded(unsigned int mesh_id) const { std::lock_guard<std::mutex> lock(mtx); return meshes.at(mesh_id).geometry != nullptr; }
+
+    std::string get_error(unsigned int mesh_id) const { std::lock_guard<std::mutex> lock(mtx); return meshes.at(mesh_id).error; }
+
+    /* Mede de novo a memória de uma malha carregada e descarrega o que passar do
+    orçamento. Necessário no modo preguiçoso, em que a malha cresce com as consultas.
+    */
+    void refresh_memory(unsigned int mesh_id)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        mesh_entry& entry = meshes.at(mesh_id);
+        if (!entry.geometry) return;
+        total_bytes -= entry.bytes;
+        entry.bytes = entry.geometry->memory_usage();
+        total_bytes += entry.bytes;
+        evict_over_budget(mesh_id);
+    }
+
+    /* Memória estimada de uma malha, em bytes (0 se estiver descarregada).
+    Medida ao carregar, a cada seleção e em refresh_memory().
+    */
+    size_t get_mesh_memory(unsigned int mesh_id) const { std::lock_guard<std::mutex> lock(mtx); return meshes.at(mesh_id).bytes; }
+
+    size_t get_total_memory() const { std::lock_guard<std::mutex> lock(mtx); return total_bytes; }
+
+    size_t get_memory_budget() const { std::lock_guard<std::mutex> lock(mtx); return mem_budget; }
+
+    /* Altera o orçamento (0 = sem limite) e descarrega o que passar dele. */
+    void set_memory_budget(size_t memory_budget_bytes)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        mem_budget = memory_budget_bytes;
+        evict_over_budget(selected_id < 0 ? (unsigned int)meshes.size() : (unsigned int)selected_id);
+    }
+};
+
+#endif
@@ -50,9 +50,200 @@ private:
     // Vetor para guardar todos os ponteiros de half-edge para o destrutor (essencial para evitar memory leaks)
     std::vector<HalfEdge*> all_half_edges;
 
+    // Mapa para rastrear arestas já criadas e encontrar gêmeas (twins)
+    std::map<std::pair<unsigned int, unsigned int>, HalfEdge*> edge_map;
+
+    // --- Modo preguiçoso ---
+    // As listas de vértices das faces ficam guardadas de forma compacta: os vértices
+    // (base 0) da face f estão em lazy_fa_vxs[lazy_fa_offsets[f] .. lazy_fa_offsets[f+1]).
+    // A face só ganha half-edges quando uma consulta a toca.
+    bool lazy, lazy_complete;
+    size_t lazy_fas_built;
+    std::vector<size_t> lazy_fa_offsets;
+    std::vector<unsigned int> lazy_fa_vxs;
+    std::vector<bool> lazy_fa_built;
+    std::vector<bool> lazy_vx_built;
+    // Índice vértice -> faces, montado na primeira consulta: as faces do vértice v
+    // estão em lazy_vx_fas[lazy_vx_offsets[v] .. lazy_vx_offsets[v+1]).
+    std::vector<size_t> lazy_vx_offsets;
+    std::vector<unsigned int> lazy_vx_fas;
+
+    /* Cria a face 'fa_id' com os vértices (base 0) dados, reaproveitando as
+    half-edges já criadas por faces vizinhas e ligando os ponteiros next/prev.
+    'face_idx' é o índice da face no arquivo, usado na mensagem de erro.
+    */
+    void build_face(unsigned int fa_id, const unsigned int *vertex_ids, size_t n_vertices, int face_idx)
+    {
+        Face *new_fa = new Face;
+        new_fa->id = fa_id;
+        new_fa->he = nullptr;
+        fa_unomap[new_fa->id] = new_fa;
+
+        std::vector<HalfEdge*> face_hes;
+
+        // 3. Criar ou encontrar as half-edges para a face atual
+        for (size_t i = 0; i < n_vertices; ++i)
+        {
+            unsigned int v1_id = vertex_ids[i];
+            unsigned int v2_id = vertex_ids[(i + 1) % n_vertices];
+
+            if (vx_unomap.find(v1_id) == vx_unomap.end() || vx_unomap.find(v2_id) == vx_unomap.end()) {
+                 throw std::runtime_error("Erro: Face " + std::to_string(face_idx) + " referencia um vertice invalido.");
+            }
+
+            std::pair<unsigned int, unsigned int> edge_key = {std::min(v1_id, v2_id), std::max(v1_id, v2_id)};
+            
+            auto it = edge_map.find(edge_key);
+            HalfEdge* he1_ptr = nullptr;
+
+            if (it == edge_map.end()) // Aresta não existe, criar nova
+            {
+                HalfEdge* he1 = new HalfEdge();
+                HalfEdge* he2 = new HalfEdge();
+                all_half_edges.push_back(he1);
+                all_half_edges.push_back(he2);
+
+                he1->id = he_id_ctr++;
+                he2->id = he_id_ctr++;
+                he_unomap[he1->id] = he1;
+                he_unomap[he2->id] = he2;
+
+                he1->twin = he2; he2->twin = he1;
+                
+                he1->vx = vx_unomap.at(v2_id);
+                he2->vx = vx_unomap.at(v1_id);
+
+                if (vx_unomap.at(v1_id)->he == nullptr) vx_unomap.at(v1_id)->he = he1;
+                if (vx_unomap.at(v2_id)->he == nullptr) vx_unomap.at(v2_id)->he = he2;
+
+                he1->fa = nullptr; he2->fa = nullptr;
+                
+                edge_map[edge_key] = he1;
+                he1_ptr = he1;
+            }
+            else {
+                he1_ptr = it->second;
+            }
+            
+            // Adiciona a half-edge correta para esta face (a que aponta de v1 para v2)
+            if(he1_ptr->vx->id == v2_id) {
+                face_hes.push_back(he1_ptr);
+            } else {
+                face_hes.push_back(he1_ptr->twin);
+            }
+        }
+        
+        // 4. Ligar os ponteiros next/prev e atribuir a face
+        for(size_t i = 0; i < face_hes.size(); ++i)
+        {
+            HalfEdge* he_curr = face_hes[i];
+            HalfEdge* he_prev = face_hes[(i + face_hes.size() - 1) % face_hes.size()];
+            
+            he_curr->prevhe = he_prev;
+            he_prev->nexthe = he_curr;
+            he_curr->fa = new_fa;
+        }
+        new_fa->he = face_hes[0];
+    }
+
+    /* (Modo preguiçoso) Constrói a face 'fa_id' se ainda não existir. */
+    void lazy_build_face(unsigned int fa_id)
+    {
+        if (lazy_fa_built[fa_id]) return;
+        lazy_fa_built[fa_id] = true;
+        lazy_fas_built++;
+        build_face(fa_id, &lazy_fa_vxs[lazy_fa_offsets[fa_id]],
+                   lazy_fa_offsets[fa_id + 1] - lazy_fa_offsets[fa_id], (int)fa_id + 1);
+        if (lazy_fas_built == fa_id_ctr) edge_map.clear(); // Nenhuma aresta nova será criada.
+    }
+
+    /* (Modo preguiçoso) Constrói todas as faces que tocam o vértice, de modo que
+    a vizinhança dele (e as gêmeas das suas arestas) fique completa.
+    */
+    void lazy_build_vertex_region(unsigned int vx_id)
+    {
+        if (lazy_vx_built[vx_id]) return;
+        lazy_vx_built[vx_id] = true;
+
+        if (lazy_vx_offsets.empty()) {
+            // Contagem + prefixo, como um counting sort: uma passada sobre as listas de faces.
+            lazy_vx_offsets.assign(vx_id_ctr + 1, 0);
+            for (unsigned int v : lazy_fa_vxs) lazy_vx_offsets[v + 1]++;
+            for (unsigned int v = 0; v < vx_id_ctr; ++v) lazy_vx_offsets[v + 1] += lazy_vx_offsets[v];
+            lazy_vx_fas.resize(lazy_fa_vxs.size());
+            std::vector<size_t> fill(lazy_vx_offsets.begin(), lazy_vx_offsets.end() - 1);
+            for (unsigned int f = 0; f < fa_id_ctr; ++f) {
+                for (size_t i = lazy_fa_offsets[f]; i < lazy_fa_offsets[f + 1]; ++i) {
+                    lazy_vx_fas[fill[lazy_fa_vxs[i]]++] = f;
+                }
+            }
+        }
+        if (lazy_vx_offsets[vx_id] == lazy_vx_offsets[vx_id + 1]) return;
+        for (size_t i = lazy_vx_offsets[vx_id]; i < lazy_vx_offsets[vx_id + 1]; ++i) {
+            lazy_build_face(lazy_vx_fas[i]);
+        }
+
+        // O giro em torno do vértice para na borda, então o resultado depende da
+        // half-edge inicial. Usa a mesma que o modo normal escolheria: a primeira
+        // criada na face de menor ID que contém o vértice.
+        unsigned int first_fa = lazy_vx_fas[lazy_vx_offsets[vx_id]];
+        const unsigned int *fa_vxs = &lazy_fa_vxs[lazy_fa_offsets[first_fa]];
+        HalfEdge *he = fa_unomap.at(first_fa)->he;
+        if (fa_vxs[0] != vx_id) {
+            // Aresta (v[k-1], v[k]) da face: a half-edge do vértice é a gêmea dela.
+            for (size_t k = 1; fa_vxs[k] != vx_id; ++k) he = he->nexthe;
+            he = he->twin;
+        }
+        vx_unomap.at(vx_id)->he = he;
+    }
+
+    /* Garante que a vizinhança do vértice esteja construída (no-op no modo normal). */
+    void ensure_vertex(unsigned int vx_id)
+    {
+        if (!lazy || lazy_complete) return;
+        if (vx_id >= vx_id_ctr) throw std::out_of_range("vertice");
+        lazy_build_vertex_region(vx_id);
+    }
+
+    /* Garante que a face e todas as faces que compartilham vértices com ela estejam construídas. */
+    void ensure_face(unsigned int fa_id)
+    {
+        if (!lazy || lazy_complete) return;
+        if (fa_id >= fa_id_ctr) throw std::out_of_range("face");
+        for (size_t i = lazy_fa_offsets[fa_id]; i < lazy_fa_offsets[fa_id + 1]; ++i) {
+            lazy_build_vertex_region(lazy_fa_vxs[i]);
+        }
+    }
+
+    /* Garante que toda a topologia esteja construída (no-op no modo normal). */
+    void ensure_all()
+    {
+        if (!lazy || lazy_complete) return;
+        for (unsigned int v = 0; v < vx_id_ctr; ++v) lazy_build_vertex_region(v);
+        lazy_complete = true;
+
+        // Com a topologia completa, as listas e índices do modo preguiçoso não são mais usados.
+        std::vector<size_t>().swap(lazy_fa_offsets);
+        std::vector<unsigned int>().swap(lazy_fa_vxs);
+        std::vector<bool>().swap(lazy_fa_built);
+        std::vector<bool>().swap(lazy_vx_built);
+        std::vector<size_t>().swap(lazy_vx_offsets);
+        std::vector<unsigned int>().swap(lazy_vx_fas);
+        edge_map.clear();
+    }
+
 public:
-    // Construtor usa a lógica robusta que desenvolvemos, que é mais simples e correta
-    TwoDHalfEdgeGeometry(const std::vector<double>& vxs_pos, const std::map<int, std::vector<int>>& fa_vxs)
+    /* Constrói a estrutura a partir das posições e das faces lidas do .obj.
+
+    Com 'lazy' = true, só os vértices são criados agora: as listas das faces são
+    validadas e guardadas, e as half-edges de cada região são montadas (e
+    mantidas) na primeira consulta que a toca. Nesse modo os IDs das faces são
+    os mesmos do modo normal, mas os IDs das half-edges seguem a ordem em que
+    as regiões foram consultadas, e uma half-edge só existe (e pode ser
+    consultada por ID) depois que alguma face dela foi construída.
+    */
+    TwoDHalfEdgeGeometry(const std::vector<double>& vxs_pos, const std::map<int, std::vector<int>>& fa_vxs, bool lazy = false)
+        : lazy(lazy), lazy_complete(!lazy), lazy_fas_built(0)
     {
         vx_id_ctr = he_id_ctr = fa_id_ctr = 0;
 
@@ -67,87 +258,43 @@ public:
             vx_unomap[new_vx->id] = new_vx;
         }
 
-        // Mapa para rastrear arestas já criadas e encontrar gêmeas (twins)
-        std::map<std::pair<unsigned int, unsigned int>, HalfEdge*> edge_map;
+        if (lazy)
+        {
+            // 2. Guardar as listas das faces para construção sob demanda
+            lazy_fa_offsets.push_back(0);
+            for (const auto& [face_idx, vertex_indices] : fa_vxs)
+            {
+                if (vertex_indices.size() < 3) continue;
+                for (int vertex_index : vertex_indices) {
+                    if (vertex_index < 1 || (unsigned int)vertex_index > vx_id_ctr) {
+                        throw std::runtime_error("Erro: Face " + std::to_string(face_idx) + " referencia um vertice invalido.");
+                    }
+                    lazy_fa_vxs.push_back(vertex_index - 1);
+                }
+                lazy_fa_offsets.push_back(lazy_fa_vxs.size());
+                fa_id_ctr++;
+            }
+            lazy_fa_built.assign(fa_id_ctr, false);
+            lazy_vx_built.assign(vx_id_ctr, false);
+            return;
+        }
 
         // 2. Iterar sobre as faces para criar arestas e faces
+        std::vector<unsigned int> vertex_ids;
         for (const auto& [face_idx, vertex_indices] : fa_vxs)
         {
             if (vertex_indices.size() < 3) continue;
 
-            Face *new_fa = new Face;
-            new_fa->id = fa_id_ctr++;
-            new_fa->he = nullptr;
-            fa_unomap[new_fa->id] = new_fa;
-
-            std::vector<HalfEdge*> face_hes;
-
-            // 3. Criar ou encontrar as half-edges para a face atual
-            for (size_t i = 0; i < vertex_indices.size(); ++i)
-            {
-                unsigned int v1_id = vertex_indices[i] - 1;
-                unsigned int v2_id = vertex_indices[(i + 1) % vertex_indices.size()] - 1;
-
-                if (vx_unomap.find(v1_id) == vx_unomap.end() || vx_unomap.find(v2_id) == vx_unomap.end()) {
-                     throw std::runtime_error("Erro: Face " + std::to_string(face_idx) + " referencia um vertice invalido.");
-                }
-
-                std::pair<unsigned int, unsigned int> edge_key = {std::min(v1_id, v2_id), std::max(v1_id, v2_id)};
-                
-                auto it = edge_map.find(edge_key);
-                HalfEdge* he1_ptr = nullptr;
-
-                if (it == edge_map.end()) // Aresta não existe, criar nova
-                {
-                    HalfEdge* he1 = new HalfEdge();
-                    HalfEdge* he2 = new HalfEdge();
-                    all_half_edges.push_back(he1);
-                    all_half_edges.push_back(he2);
-
-                    he1->id = he_id_ctr++;
-                    he2->id = he_id_ctr++;
-                    he_unomap[he1->id] = he1;
-                    he_unomap[he2->id] = he2;
-
-                    he1->twin = he2; he2->twin = he1;
-                    
-                    he1->vx = vx_unomap.at(v2_id);
-                    he2->vx = vx_unomap.at(v1_id);
-
-                    if (vx_unomap.at(v1_id)->he == nullptr) vx_unomap.at(v1_id)->he = he1;
-                    if (vx_unomap.at(v2_id)->he == nullptr) vx_unomap.at(v2_id)->he = he2;
-
-                    he1->fa = nullptr; he2->fa = nullptr;
-                    
-                    edge_map[edge_key] = he1;
-                    he1_ptr = he1;
-                }
-                else {
-                    he1_ptr = it->second;
-                }
-                
-                // Adiciona a half-edge correta para esta face (a que aponta de v1 para v2)
-                if(he1_ptr->vx->id == v2_id) {
-                    face_hes.push_back(he1_ptr);
-                } else {
-                    face_hes.push_back(he1_ptr->twin);
-                }
-            }
-            
-            // 4. Ligar os ponteiros next/prev e atribuir a face
-            for(size_t i = 0; i < face_hes.size(); ++i)
-            {
-                HalfEdge* he_curr = face_hes[i];
-                HalfEdge* he_prev = face_hes[(i + face_hes.size() - 1) % face_hes.size()];
-                
-                he_curr->prevhe = he_prev;
-                he_prev->nexthe = he_curr;
-                he_curr->fa = new_fa;
-            }
-            new_fa->he = face_hes[0];
+            vertex_ids.clear();
+            for (int vertex_index : vertex_indices) vertex_ids.push_back(vertex_index - 1);
+            build_face(fa_id_ctr++, vertex_ids.data(), vertex_ids.size(), face_idx);
         }
+        edge_map.clear();
     }
 
+    /* Indica se a estrutura foi criada no modo preguiçoso. */
+    bool is_lazy() const { return lazy; }
+
     // **DESTRUTOR CORRIGIDO** para evitar crashes
     ~TwoDHalfEdgeGeometry()
     {
@@ -156,6 +303,81 @@ public:
         for (auto const& [id, vx] : vx_unomap) { delete vx; }
     }
 
+    /* Retorna uma estimativa, em bytes, da memória ocupada pela estrutura:
+    os próprios nós (vértices, half-edges e faces) mais os buckets e nós das
+    tabelas de IDs. Usada pelo MeshRegistry para respeitar o orçamento de memória.
+    */
+    size_t memory_usage() const
+    {
+        // Cada entrada de unordered_map custa um nó (próximo, chave, valor) e um bucket.
+        const size_t map_node = 2 * sizeof(void*) + sizeof(unsigned int) + sizeof(void*);
+        size_t total = sizeof(*this);
+        total += vx_unomap.size() * (sizeof(Vertex) + map_node) + vx_unomap.bucket_count() * sizeof(void*);
+        total += he_unomap.size() * (sizeof(HalfEdge) + map_node) + he_unomap.bucket_count() * sizeof(void*);
+        total += fa_unomap.size() * (sizeof(Face) + map_node) + fa_unomap.bucket_count() * sizeof(void*);
+        total += all_half_edges.capacity() * sizeof(HalfEdge*);
+        // Nós da árvore do edge_map (três ponteiros + cor + chave + valor).
+        total += edge_map.size() * (4 * sizeof(void*) + sizeof(std::pair<unsigned int, unsigned int>) + sizeof(void*));
+        total += lazy_fa_offsets.capacity() * sizeof(size_t) + lazy_fa_vxs.capacity() * sizeof(unsigned int);
+        total += (lazy_fa_built.capacity() + lazy_vx_built.capacity()) / 8;
+        total += lazy_vx_offsets.capacity() * sizeof(size_t) + lazy_vx_fas.capacity() * sizeof(unsigned int);
+        return total;
+    }
+
+    /* Número de vértices e de faces. Os IDs são contíguos: 0 .. N-1. */
+    unsigned int get_vertex_count() const { return vx_id_ctr; }
+    unsigned int get_face_count() const { return fa_id_ctr; }
+
+    /* Dado um ID de vértice, retorna sua posição (x, y). */
+    std::pair<double, double> get_vertex_position(unsigned int vx_id) const
+    {
+        const Vertex *vx = vx_unomap.at(vx_id);
+        return std::make_pair(vx->x, vx->y);
+    }
+
+    /* Chama 'callback(he_id, origem_id, destino_id, face_id, face_gemea_id)' para
+    cada half-edge, sem montar estruturas intermediárias. Faces inexistentes
+    (borda) são passadas como -1. No modo preguiçoso, constrói toda a topologia antes.
+    */
+    template <typename Callback>
+    void for_each_half_edge(Callback callback)
+    {
+        ensure_all();
+        for (const HalfEdge *he : all_half_edges) {
+            callback(he->id, he->twin->vx->id, he->vx->id,
+                     he->fa ? (long)he->fa->id : -1L,
+                     he->twin->fa ? (long)he->twin->fa->id : -1L);
+        }
+    }
+
+    /* Chama 'callback(face_id, vertices, n_vertices)' para cada face, em ordem de
+    ID, com os IDs dos vértices na ordem do arquivo. O buffer de vértices é
+    reaproveitado entre as chamadas. No modo preguiçoso, enquanto a topologia não
+    está completa, lê as listas guardadas sem construí-la.
+    */
+    template <typename Callback>
+    void for_each_face(Callback callback) const
+    {
+        if (!lazy_complete) {
+            for (unsigned int f = 0; f < fa_id_ctr; ++f) {
+                callback(f, &lazy_fa_vxs[lazy_fa_offsets[f]], lazy_fa_offsets[f + 1] - lazy_fa_offsets[f]);
+            }
+            return;
+        }
+
+        std::vector<unsigned int> vertex_ids;
+        for (unsigned int f = 0; f < fa_id_ctr; ++f) {
+            vertex_ids.clear();
+            const HalfEdge *start_he = fa_unomap.at(f)->he;
+            const HalfEdge *he = start_he;
+            do {
+                vertex_ids.push_back(he->twin->vx->id); // Origem da half-edge.
+                he = he->nexthe;
+            } while (he != start_he && he != nullptr);
+            callback(f, vertex_ids.data(), vertex_ids.size());
+        }
+    }
+
     /* Retorna um mapa com IDs de vértices e suas posições (x, y).
     */
     std::unordered_map<unsigned int, std::pair<double, double>> get_vertexes()
@@ -173,6 +395,7 @@ public:
     std::vector<unsigned int> get_vx_edges_id(unsigned int vx_id)
     {
         std::vector<unsigned int> vx_edges_id;
+        ensure_vertex(vx_id);
         HalfEdge *he = vx_unomap.at(vx_id)->he;
         if (!he) return vx_edges_id;
         HalfEdge *start_he = he;
@@ -187,6 +410,7 @@ public:
     std::vector<unsigned int> get_vx_faces_id(unsigned int vx_id)
     {
         std::vector<unsigned int> vx_faces_id;
+        ensure_vertex(vx_id);
         HalfEdge *he = vx_unomap.at(vx_id)->he;
         if (!he) return vx_faces_id;
         HalfEdge *start_he = he;
@@ -203,6 +427,7 @@ public:
     std::vector<unsigned int> face_get_adjacent_faces_ids(unsigned int fa_id)
     {
         std::vector<unsigned int> adj_fas_id;
+        ensure_face(fa_id);
         HalfEdge *he = fa_unomap.at(fa_id)->he;
         if (!he) return adj_fas_id;
         HalfEdge *start_he = he;
@@ -220,6 +445,11 @@ public:
     {
         std::vector<unsigned int> adj_fas_id;
         HalfEdge *he = he_unomap.at(he_id);
+        if (lazy) {
+            // A face do outro lado pode ainda não ter sido construída.
+            ensure_vertex(he->vx->id);
+            ensure_vertex(he->twin->vx->id);
+        }
         if (he->fa) { adj_fas_id.push_back(he->fa->id); }
         if (he->twin && he->twin->fa) { adj_fas_id.push_back(he->twin->fa->id); }
         return adj_fas_id;
@@ -229,6 +459,7 @@ public:
     std::map<std::pair<unsigned int, unsigned int>, unsigned int>
     get_vxs_conn_edges_id()
     {
+        ensure_all();
         std::map<std::pair<unsigned int, unsigned int>, unsigned int> vxs_conn_edges_id;
         for (const auto& he : all_half_edges) {
             // Garante que a aresta só seja adicionada uma vez
@@ -241,6 +472,7 @@ public:
 
     std::map<unsigned int, std::vector<unsigned int>> get_faces_with_vertices()
     {
+        ensure_all();
         std::map<unsigned int, std::vector<unsigned int>> faces_map;
         for (const auto& [face_id, face_ptr] : fa_unomap) {
             if (!face_ptr || !face_ptr->he) continue;
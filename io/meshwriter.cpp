@@ -0,0 +1,161 @@
+/**
+ * @file meshwriter.cpp
+ * @brief Exporta a geometria Half-Edge para arquivos .obj (texto) e .ply (binário).
+ *
+ * Os dois formatos são escritos em fluxo: vértices e faces são percorridos
+ * diretamente na TwoDHalfEdgeGeometry e formatados num buffer de tamanho fixo,
+ * despejado no arquivo sempre que enche. A memória extra não depende do
+ * tamanho da malha.
+ */
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <charconv>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+#include <iostream>
+
+#include "../dsa/TwoDHalfEdgeGeometry.h"
+
+/*Buffer de saída de tamanho fixo sobre um std::ofstream.*/
+class BufferedWriter
+{
+private:
+    static const size_t BUFFER_SIZE = 1 << 16;
+    // Maior item escrito de uma vez (um double em notação científica cabe com folga).
+    static const size_t MAX_ITEM_SIZE = 64;
+
+    std::ofstream *out;
+    char buffer[BUFFER_SIZE];
+    size_t used;
+
+    void reserve(size_t n)
+    {
+        if (used + n > BUFFER_SIZE) flush();
+    }
+
+public:
+    BufferedWriter(std::ofstream *out) : out(out), used(0) {}
+    ~BufferedWriter() { flush(); }
+
+    void flush()
+    {
+        out->write(buffer, used);
+        used = 0;
+    }
+
+    void put(char c)
+    {
+        reserve(1);
+        buffer[used++] = c;
+    }
+
+    void put(const char *text)
+    {
+        while (*text) put(*text++);
+    }
+
+    /*Escreve um número em texto com std::to_chars (sem locale e sem alocação).*/
+    template <typename T>
+    void put_number(T value)
+    {
+        reserve(MAX_ITEM_SIZE);
+        used = std::to_chars(buffer + used, buffer + BUFFER_SIZE, value).ptr - buffer;
+    }
+
+    /*Escreve os bytes de 'value' em little-endian, independente da arquitetura.*/
+    template <typename T>
+    void put_le(T value)
+    {
+        static_assert(sizeof(T) == 4 || sizeof(T) == 8, "Apenas tipos de 4 ou 8 bytes.");
+        typedef typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type bits_t;
+        bits_t bits;
+        std::memcpy(&bits, &value, sizeof(T));
+        reserve(sizeof(T));
+        for (size_t i = 0; i < sizeof(T); ++i) buffer[used++] = (char)((bits >> (8 * i)) & 0xFF);
+    }
+};
+
+/**
+ * @brief Escreve a geometria num arquivo .obj (z = 0, índices a partir de 1).
+ */
+bool write_obj_file(const std::string& filepath, TwoDHalfEdgeGeometry& geometry)
+{
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Erro: Nao foi possivel criar o arquivo: " << filepath << std::endl;
+        return false;
+    }
+
+    {
+        BufferedWriter writer(&file);
+        for (unsigned int v = 0; v < geometry.get_vertex_count(); ++v) {
+            auto pos = geometry.get_vertex_position(v);
+            writer.put("v ");
+            writer.put_number(pos.first);
+            writer.put(' ');
+            writer.put_number(pos.second);
+            writer.put(" 0\n");
+        }
+        geometry.for_each_face([&](unsigned int, const unsigned int *vertex_ids, size_t n_vertices) {
+            writer.put('f');
+            for (size_t i = 0; i < n_vertices; ++i) {
+                writer.put(' ');
+                writer.put_number(vertex_ids[i] + 1);
+            }
+            writer.put('\n');
+        });
+    }
+
+    // Fecha antes de verificar: o último bloco só é gravado no close().
+    file.close();
+    if (!file) {
+        std::cerr << "Erro: Falha ao escrever o arquivo: " << filepath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Escreve a geometria num arquivo .ply binário little-endian.
+ *
+ * Vértices com x, y, z em double (z = 0); faces como lista uint de índices int (a partir de 0).
+ */
+bool write_ply_file(const std::string& filepath, TwoDHalfEdgeGeometry& geometry)
+{
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Erro: Nao foi possivel criar o arquivo: " << filepath << std::endl;
+        return false;
+    }
+
+    {
+        BufferedWriter writer(&file);
+        writer.put("ply\nformat binary_little_endian 1.0\nelement vertex ");
+        writer.put_number(geometry.get_vertex_count());
+        writer.put("\nproperty double x\nproperty double y\nproperty double z\nelement face ");
+        writer.put_number(geometry.get_face_count());
+        writer.put("\nproperty list uint int vertex_indices\nend_header\n");
+
+        for (unsigned int v = 0; v < geometry.get_vertex_count(); ++v) {
+            auto pos = geometry.get_vertex_position(v);
+            writer.put_le(pos.first);
+            writer.put_le(pos.second);
+            writer.put_le(0.0);
+        }
+        geometry.for_each_face([&](unsigned int, const unsigned int *vertex_ids, size_t n_vertices) {
+            writer.put_le((uint32_t)n_vertices);
+            for (size_t i = 0; i < n_vertices; ++i) writer.put_le((int32_t)vertex_ids[i]);
+        });
+    }
+
+    // Fecha antes de verificar: o último bloco só é gravado no close().
+    file.close();
+    if (!file) {
+        std::cerr << "Erro: Falha ao escrever o arquivo: " << filepath << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -3,49 +3,160 @@
  * @brief Ponto de entrada principal do programa de geometria 2D.
  *
  * Responsável por:
- * 1. Processar argumentos para obter o caminho do arquivo .obj.
- * 2. Chamar o leitor de .obj.
- * 3. Construir a estrutura de dados Half-Edge.
- * 4. Iniciar o renderizador, que agora gerencia toda a interatividade.
+ * 1. Processar argumentos para obter os caminhos dos arquivos .obj e as opções.
+ * 2. Com --renderizar, gerar uma imagem de cada arquivo sem abrir janela.
+ * 3. Caso contrário, carregar todos os arquivos, em paralelo, no registro de
+ *    malhas, selecionar a primeira carregada com sucesso e iniciar o
+ *    renderizador, que agora gerencia toda a interatividade.
  */
 
 #include <iostream>
 #include <string>
 #include <vector>
-#include <map>
+#include <chrono>
+#include <filesystem>
+#include <stdexcept>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
 
 #include "dsa/TwoDHalfEdgeGeometry.h"
+#include "dsa/MeshRegistry.h"
 
 // Protótipos de Funções
-bool read_obj_file(const std::string& filepath, std::vector<double>& vxs_pos, std::map<int, std::vector<int>>& fa_vxs);
-void start_renderer(int argc, char* argv[], TwoDHalfEdgeGeometry& geometry);
+void start_renderer(int argc, char* argv[], MeshRegistry& registry, unsigned int max_threads);
+bool render_offscreen(TwoDHalfEdgeGeometry& geometry, const std::string& filepath, int width, int height,
+                      bool fill_faces, bool show_labels, unsigned int max_threads);
 
+/**
+ * @brief Renderiza cada arquivo em '<pasta>/<id>_<nome>.<formato>', sem janela.
+ *
+ * Processa em fluxo: cada thread lê um arquivo, gera a imagem e descarta a
+ * geometria antes de pegar o próximo, então no máximo uma malha por thread fica
+ * em memória. Os IDs são as posições em 'paths', como no registro de malhas.
+ * @return O número de arquivos que falharam.
+ */
+int render_all_offscreen(const std::vector<std::string>& paths, bool lazy, const std::string& output_dir,
+                         const std::string& format, int width, int height, bool fill_faces, bool show_labels,
+                         unsigned int max_threads) {
+    std::error_code ec;
+    std::filesystem::create_directories(output_dir, ec);
+
+    // As threads se dividem entre os arquivos; o que sobrar vai para a rasterização de cada imagem.
+    if (max_threads == 0) max_threads = std::max(1u, std::thread::hardware_concurrency());
+    unsigned int n_workers = std::min<unsigned int>(max_threads, (unsigned int)paths.size());
+    unsigned int raster_threads = std::max(1u, max_threads / n_workers);
+
+    std::atomic<size_t> next(0);
+    std::atomic<int> failures(0), rendered(0);
+    std::mutex log_mtx;
+    auto start = std::chrono::steady_clock::now();
+    auto worker = [&]() {
+        for (size_t id = next++; id < paths.size(); id = next++) {
+            std::string error;
+            auto geometry = MeshRegistry::build_from_file(paths[id], lazy, error);
+            if (!geometry) {
+                std::lock_guard<std::mutex> lock(log_mtx);
+                std::cerr << "Erro na malha " << id << " (" << paths[id] << "): " << error << std::endl;
+                failures++;
+                continue;
+            }
+            std::string name = std::filesystem::path(paths[id]).stem().string();
+            std::string image_path = (std::filesystem::path(output_dir) / (std::to_string(id) + "_" + name + "." + format)).string();
+            if (render_offscreen(*geometry, image_path, width, height, fill_faces, show_labels, raster_threads)) rendered++;
+            else failures++;
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned int t = 1; t < n_workers; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& th : pool) th.join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << rendered << " imagem(ns) gerada(s) em " << output_dir << " (" << seconds << " s)." << std::endl;
+    return failures;
+}
 
 int main(int argc, char* argv[]) {
-    if (argc < 2) {
-        std::cerr << "Uso: " << argv[0] << " <caminho_para_o_arquivo.obj>" << std::endl;
+    std::vector<std::string> obj_filepaths;
+    size_t memory_budget_mb = 0;
+    unsigned int max_threads = 0;
+    bool lazy = false;
+    std::string render_dir, render_format = "png";
+    int render_width = 800, render_height = 600;
+    bool render_faces = false, render_labels = false;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--memoria" && i + 1 < argc) {
+                memory_budget_mb = std::stoul(argv[++i]);
+            } else if (arg == "--preguicoso") {
+                lazy = true;
+            } else if (arg == "--renderizar" && i + 1 < argc) {
+                render_dir = argv[++i];
+            } else if (arg == "--tamanho" && i + 1 < argc) {
+                std::string size = argv[++i];
+                size_t sep = size.find('x');
+                if (sep == std::string::npos) throw std::invalid_argument("--tamanho sem 'x'");
+                render_width = std::stoi(size.substr(0, sep));
+                render_height = std::stoi(size.substr(sep + 1));
+            } else if (arg == "--formato" && i + 1 < argc) {
+                render_format = argv[++i];
+            } else if (arg == "--faces") {
+                render_faces = true;
+            } else if (arg == "--labels") {
+                render_labels = true;
+            } else if (arg == "--threads" && i + 1 < argc) {
+                max_threads = std::stoul(argv[++i]);
+            } else {
+                obj_filepaths.push_back(arg);
+            }
+        }
+    } catch (const std::exception&) {
+        obj_filepaths.clear();
+    }
+
+    if (obj_filepaths.empty() || (render_format != "png" && render_format != "ppm")) {
+        std::cerr << "Uso: " << argv[0] << " [--memoria <MB>] [--threads <n>] [--preguicoso]"
+                  << " [--renderizar <pasta> [--tamanho <L>x<A>] [--formato png|ppm] [--faces] [--labels]]"
+                  << " <arquivo.obj> [<arquivo.obj> ...]" << std::endl;
         return 1;
     }
-    std::string obj_filepath = argv[1];
 
-    std::vector<double> vertex_positions;
-    std::map<int, std::vector<int>> face_vertices;
+    if (!render_dir.empty()) {
+        int failures = render_all_offscreen(obj_filepaths, lazy, render_dir, render_format, render_width, render_height,
+                                            render_faces, render_labels, max_threads);
+        return failures == 0 ? 0 : 1;
+    }
+
+    MeshRegistry registry(memory_budget_mb * 1024 * 1024, lazy);
 
-    std::cout << "Lendo o arquivo: " << obj_filepath << "..." << std::endl;
-    if (!read_obj_file(obj_filepath, vertex_positions, face_vertices)) {
-        std::cerr << "Erro fatal: Nao foi possivel ler o arquivo .obj." << std::endl;
+    std::cout << "Lendo e construindo " << obj_filepaths.size() << " arquivo(s)..." << std::endl;
+    auto ids = registry.load_files(obj_filepaths, max_threads);
+
+    int first_loaded = -1;
+    for (unsigned int id : ids) {
+        if (!registry.get_error(id).empty()) {
+            std::cerr << "Erro na malha " << id << " (" << registry.get_path(id) << "): " << registry.get_error(id) << std::endl;
+        } else if (first_loaded < 0) {
+            first_loaded = (int)id;
+        }
+    }
+    if (first_loaded < 0) {
+        std::cerr << "Erro fatal: Nenhum arquivo .obj pode ser carregado." << std::endl;
         return 1;
     }
-    std::cout << "Arquivo lido com sucesso." << std::endl;
 
-    std::cout << "Construindo a estrutura de dados Half-Edge..." << std::endl;
     try {
-        TwoDHalfEdgeGeometry geometry(vertex_positions, face_vertices);
+        registry.select(first_loaded);
         std::cout << "Estrutura de dados construida com sucesso!" << std::endl;
         std::cout << "\nIniciando a janela grafica..." << std::endl;
-        
+
         // Inicia o renderer, que cuidará de todo o loop principal e interatividade.
-        start_renderer(argc, argv, geometry);
+        start_renderer(argc, argv, registry, max_threads);
 
     } catch (const std::exception& e) {
         std::cerr << "Um erro ocorreu durante a construcao da geometria: " << e.what() << std::endl;
@@ -55,4 +166,3 @@ int main(int argc, char* argv[]) {
     std::cout << "\nPrograma encerrado." << std::endl;
     return 0;
 }
-
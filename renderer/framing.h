@@ -0,0 +1,37 @@
+#ifndef RENDERER_FRAMING_DEFINED_H
+#define RENDERER_FRAMING_DEFINED_H
+#include <algorithm>
+
+#include "../dsa/TwoDHalfEdgeGeometry.h"
+
+/* Janela de visualização (em coordenadas do mundo) usada tanto pela janela
+OpenGL quanto pelo renderizador offscreen.
+*/
+struct ViewBounds
+{
+    double left, right, bottom, top;
+};
+
+/* Enquadra todos os vértices com uma margem de 10% do maior lado (no mínimo 1). */
+inline ViewBounds compute_view_bounds(const TwoDHalfEdgeGeometry& geometry)
+{
+    double minX = 0, maxX = 0, minY = 0, maxY = 0;
+    for (unsigned int v = 0; v < geometry.get_vertex_count(); ++v) {
+        auto pos = geometry.get_vertex_position(v);
+        if (v == 0) {
+            minX = maxX = pos.first;
+            minY = maxY = pos.second;
+        }
+        minX = std::min(minX, pos.first);
+        maxX = std::max(maxX, pos.first);
+        minY = std::min(minY, pos.second);
+        maxY = std::max(maxY, pos.second);
+    }
+
+    double paddingX = (maxX - minX) * 0.1;
+    double paddingY = (maxY - minY) * 0.1;
+    double padding = std::max({1.0, paddingX, paddingY});
+    return {minX - padding, maxX + padding, minY - padding, maxY + padding};
+}
+
+#endif
@@ -0,0 +1,501 @@
+/**
+ * @file offscreen.cpp
+ * @brief Renderizador por software, sem janela, que desenha a malha numa imagem PNG ou PPM.
+ *
+ * Desenha o mesmo que a janela OpenGL (arestas brancas e, opcionalmente, os
+ * labels de vértices, arestas e faces), além dos vértices e, se pedido, das
+ * faces preenchidas. O enquadramento é o mesmo da janela (framing.h).
+ *
+ * A imagem é dividida em blocos (tiles) de TILE_SIZE x TILE_SIZE pixels. Cada
+ * primitiva é registrada nos blocos que sua caixa envolvente toca, e as threads
+ * pegam blocos inteiros para rasterizar: como cada pixel pertence a um único
+ * bloco, o framebuffer é escrito sem nenhuma sincronização.
+ */
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <iostream>
+
+#include "../dsa/TwoDHalfEdgeGeometry.h"
+#include "framing.h"
+
+namespace {
+
+const int TILE_SIZE = 64;
+
+struct Color { uint8_t r, g, b; };
+
+// Mesmas cores da janela: fundo (0.1, 0.1, 0.2), arestas brancas e labels amarelo/ciano/magenta.
+const Color BACKGROUND_COLOR = {26, 26, 51};
+const Color EDGE_COLOR = {255, 255, 255};
+const Color FACE_COLOR = {60, 70, 120};
+const Color VERTEX_LABEL_COLOR = {255, 255, 0};
+const Color EDGE_LABEL_COLOR = {0, 255, 255};
+const Color FACE_LABEL_COLOR = {255, 0, 255};
+
+// Fonte bitmap 5x7 com os únicos caracteres usados nos labels ("0".."9" e "f").
+// Cada glifo tem 7 linhas de cima para baixo; o bit 4 é a coluna da esquerda.
+const int GLYPH_WIDTH = 5, GLYPH_HEIGHT = 7, GLYPH_ADVANCE = 6;
+const uint8_t DIGIT_GLYPHS[10][GLYPH_HEIGHT] = {
+    {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}, {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E},
+    {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F}, {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E},
+    {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}, {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E},
+    {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}, {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08},
+    {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}, {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C},
+};
+const uint8_t F_GLYPH[GLYPH_HEIGHT] = {0x06, 0x09, 0x08, 0x1C, 0x08, 0x08, 0x08};
+
+struct Segment { float x0, y0, x1, y1; };
+struct Triangle { float x[3], y[3]; };
+struct Label { float x, y; Color color; std::string text; }; // (x, y): canto inferior esquerdo
+
+struct Framebuffer
+{
+    int width, height;
+    std::vector<uint8_t> rgb;
+
+    void set(int x, int y, Color c)
+    {
+        uint8_t *p = &rgb[3 * ((size_t)y * width + x)];
+        p[0] = c.r; p[1] = c.g; p[2] = c.b;
+    }
+};
+
+struct Tile { int x0, y0, x1, y1; }; // pixels [x0, x1) x [y0, y1)
+
+void fill_triangle(Framebuffer& fb, const Tile& tile, const Triangle& t, Color color)
+{
+    int min_x = std::max(tile.x0, (int)std::floor(std::min({t.x[0], t.x[1], t.x[2]})));
+    int max_x = std::min(tile.x1 - 1, (int)std::ceil(std::max({t.x[0], t.x[1], t.x[2]})));
+    int min_y = std::max(tile.y0, (int)std::floor(std::min({t.y[0], t.y[1], t.y[2]})));
+    int max_y = std::min(tile.y1 - 1, (int)std::ceil(std::max({t.y[0], t.y[1], t.y[2]})));
+
+    // Funções de aresta; o sinal da área torna o teste independente da orientação.
+    float area = (t.x[1] - t.x[0]) * (t.y[2] - t.y[0]) - (t.y[1] - t.y[0]) * (t.x[2] - t.x[0]);
+    if (area == 0.0f) return;
+    float sign = area > 0 ? 1.0f : -1.0f;
+
+    for (int y = min_y; y <= max_y; ++y) {
+        float py = y + 0.5f;
+        for (int x = min_x; x <= max_x; ++x) {
+            float px = x + 0.5f;
+            bool inside = true;
+            for (int i = 0; i < 3 && inside; ++i) {
+                int j = (i + 1) % 3;
+                float e = (t.x[j] - t.x[i]) * (py - t.y[i]) - (t.y[j] - t.y[i]) * (px - t.x[i]);
+                inside = e * sign >= 0;
+            }
+            if (inside) fb.set(x, y, color);
+        }
+    }
+}
+
+/* Desenha um quadrado de 'size' pixels centrado em (cx, cy), recortado ao bloco. */
+void stamp(Framebuffer& fb, const Tile& tile, float cx, float cy, int size, Color color)
+{
+    int x0 = (int)std::floor(cx - size * 0.5f), y0 = (int)std::floor(cy - size * 0.5f);
+    for (int y = std::max(y0, tile.y0); y < std::min(y0 + size, tile.y1); ++y) {
+        for (int x = std::max(x0, tile.x0); x < std::min(x0 + size, tile.x1); ++x) fb.set(x, y, color);
+    }
+}
+
+/* Desenha o segmento com 2 pixels de espessura, como os GL_POINTS de tamanho 2 da janela.
+As amostras são tomadas em passos fixos ao longo do segmento inteiro e só as
+próximas do bloco são desenhadas, então o resultado não depende da divisão em blocos.
+*/
+void draw_segment(Framebuffer& fb, const Tile& tile, const Segment& s, Color color)
+{
+    float dx = s.x1 - s.x0, dy = s.y1 - s.y0;
+    int steps = std::max(1, (int)std::ceil(std::max(std::fabs(dx), std::fabs(dy))));
+
+    // Recorte de Liang-Barsky contra o bloco com margem de 2 pixels, em termos de t.
+    float t0 = 0.0f, t1 = 1.0f;
+    const float p[4] = {-dx, dx, -dy, dy};
+    const float q[4] = {s.x0 - (tile.x0 - 2), (tile.x1 + 2) - s.x0, s.y0 - (tile.y0 - 2), (tile.y1 + 2) - s.y0};
+    for (int i = 0; i < 4; ++i) {
+        if (p[i] == 0.0f) {
+            if (q[i] < 0.0f) return;
+        } else {
+            float r = q[i] / p[i];
+            if (p[i] < 0.0f) t0 = std::max(t0, r);
+            else t1 = std::min(t1, r);
+        }
+    }
+    if (t0 > t1) return;
+
+    for (int i = (int)std::floor(t0 * steps); i <= std::min(steps, (int)std::ceil(t1 * steps)); ++i) {
+        float t = (float)i / steps;
+        stamp(fb, tile, s.x0 + t * dx, s.y0 + t * dy, 2, color);
+    }
+}
+
+void draw_label(Framebuffer& fb, const Tile& tile, const Label& label)
+{
+    int left = (int)std::floor(label.x), top = (int)std::floor(label.y) - GLYPH_HEIGHT;
+    for (size_t c = 0; c < label.text.size(); ++c) {
+        char ch = label.text[c];
+        const uint8_t *glyph = ch == 'f' ? F_GLYPH : (ch >= '0' && ch <= '9' ? DIGIT_GLYPHS[ch - '0'] : nullptr);
+        if (!glyph) continue;
+        int gx = left + (int)c * GLYPH_ADVANCE;
+        for (int row = 0; row < GLYPH_HEIGHT; ++row) {
+            int y = top + row;
+            if (y < tile.y0 || y >= tile.y1) continue;
+            for (int col = 0; col < GLYPH_WIDTH; ++col) {
+                int x = gx + col;
+                if (x >= tile.x0 && x < tile.x1 && (glyph[row] >> (GLYPH_WIDTH - 1 - col)) & 1) fb.set(x, y, label.color);
+            }
+        }
+    }
+}
+
+bool write_ppm(const std::string& filepath, const Framebuffer& fb)
+{
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file.is_open()) return false;
+    file << "P6\n" << fb.width << " " << fb.height << "\n255\n";
+    file.write((const char*)fb.rgb.data(), fb.rgb.size());
+    file.close(); // Fecha antes de verificar: o fim do arquivo só é gravado no close().
+    return (bool)file;
+}
+
+uint32_t crc32(const uint8_t *data, size_t n, uint32_t crc = 0)
+{
+    static uint32_t table[256];
+    static bool table_ready = [] {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+        return true;
+    }();
+    (void)table_ready;
+
+    crc = ~crc;
+    for (size_t i = 0; i < n; ++i) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+void put_be32(std::vector<uint8_t>& out, uint32_t v)
+{
+    for (int shift = 24; shift >= 0; shift -= 8) out.push_back((uint8_t)(v >> shift));
+}
+
+void write_png_chunk(std::ofstream& file, const char *type, const std::vector<uint8_t>& data)
+{
+    std::vector<uint8_t> chunk;
+    put_be32(chunk, (uint32_t)data.size());
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    put_be32(chunk, crc32(chunk.data() + 4, chunk.size() - 4));
+    file.write((const char*)chunk.data(), chunk.size());
+}
+
+/* Escreve bits em ordem LSB-primeiro, como o deflate exige. */
+struct BitWriter
+{
+    std::vector<uint8_t>& out;
+    uint32_t bit_buffer = 0;
+    int bit_count = 0;
+
+    explicit BitWriter(std::vector<uint8_t>& out) : out(out) {}
+
+    void put(uint32_t bits, int n)
+    {
+        bit_buffer |= bits << bit_count;
+        bit_count += n;
+        while (bit_count >= 8) {
+            out.push_back((uint8_t)bit_buffer);
+            bit_buffer >>= 8;
+            bit_count -= 8;
+        }
+    }
+
+    /* Códigos de Huffman vão com o bit mais significativo primeiro. */
+    void put_code(uint32_t code, int n)
+    {
+        uint32_t reversed = 0;
+        for (int i = 0; i < n; ++i) reversed |= ((code >> i) & 1) << (n - 1 - i);
+        put(reversed, n);
+    }
+
+    void finish() { if (bit_count > 0) put(0, 8 - bit_count); }
+};
+
+const uint16_t LENGTH_BASE[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                  35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+const uint8_t LENGTH_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+const uint16_t DIST_BASE[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769,
+                                1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+const uint8_t DIST_EXTRA[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+/* Símbolo de literal/comprimento com o código de Huffman fixo do deflate. */
+void put_fixed_symbol(BitWriter& bits, unsigned int symbol)
+{
+    if (symbol < 144) bits.put_code(0x30 + symbol, 8);
+    else if (symbol < 256) bits.put_code(0x190 + symbol - 144, 9);
+    else if (symbol < 280) bits.put_code(symbol - 256, 7);
+    else bits.put_code(0xC0 + symbol - 280, 8);
+}
+
+/* Comprime 'data' num único bloco deflate com Huffman fixo. As repetições são
+achadas por LZ77 com uma tabela hash de 3 bytes e cadeias de tamanho limitado:
+bem mais simples que a zlib, mas suficiente para imagens com grandes áreas de
+cor uniforme, como as geradas aqui.
+*/
+void deflate_fixed(const std::vector<uint8_t>& data, std::vector<uint8_t>& out)
+{
+    const size_t WINDOW = 32768, MIN_MATCH = 3, MAX_MATCH = 258;
+    const int HASH_BITS = 15, MAX_CHAIN = 16;
+    std::vector<int64_t> head(1 << HASH_BITS, -1), prev(WINDOW, -1);
+    auto hash = [&](size_t i) {
+        return ((data[i] << 10) ^ (data[i + 1] << 5) ^ data[i + 2]) & ((1u << HASH_BITS) - 1);
+    };
+    auto insert = [&](size_t i) {
+        if (i + MIN_MATCH > data.size()) return;
+        uint32_t h = hash(i);
+        prev[i % WINDOW] = head[h];
+        head[h] = (int64_t)i;
+    };
+
+    BitWriter bits(out);
+    bits.put(1, 1); // BFINAL
+    bits.put(1, 2); // BTYPE = 01 (Huffman fixo)
+
+    size_t i = 0;
+    while (i < data.size()) {
+        size_t best_len = 0, best_dist = 0;
+        if (i + MIN_MATCH <= data.size()) {
+            size_t max_len = std::min(MAX_MATCH, data.size() - i);
+            int64_t candidate = head[hash(i)];
+            for (int chain = 0; chain < MAX_CHAIN && candidate >= 0 && i - candidate <= WINDOW; ++chain) {
+                size_t len = 0;
+                while (len < max_len && data[candidate + len] == data[i + len]) ++len;
+                if (len > best_len) {
+                    best_len = len;
+                    best_dist = i - candidate;
+                    if (len == max_len) break;
+                }
+                candidate = prev[candidate % WINDOW];
+            }
+        }
+
+        if (best_len >= MIN_MATCH) {
+            int lc = 28;
+            while (LENGTH_BASE[lc] > best_len) --lc;
+            put_fixed_symbol(bits, 257 + lc);
+            bits.put(best_len - LENGTH_BASE[lc], LENGTH_EXTRA[lc]);
+            int dc = 29;
+            while (DIST_BASE[dc] > best_dist) --dc;
+            bits.put_code(dc, 5);
+            bits.put(best_dist - DIST_BASE[dc], DIST_EXTRA[dc]);
+            for (size_t k = 0; k < best_len; ++k) insert(i + k);
+            i += best_len;
+        } else {
+            put_fixed_symbol(bits, data[i]);
+            insert(i);
+            ++i;
+        }
+    }
+    put_fixed_symbol(bits, 256); // fim do bloco
+    bits.finish();
+}
+
+/* PNG RGB de 8 bits, comprimido sem depender da zlib. Cada linha recebe o
+filtro (nenhum, Sub ou Up) com a menor soma dos resíduos, e o resultado passa
+por deflate_fixed(). O PPM continua sendo o caminho mais rápido, sem compressão.
+*/
+bool write_png(const std::string& filepath, const Framebuffer& fb)
+{
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file.is_open()) return false;
+    const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    file.write((const char*)signature, 8);
+
+    std::vector<uint8_t> ihdr;
+    put_be32(ihdr, fb.width);
+    put_be32(ihdr, fb.height);
+    ihdr.insert(ihdr.end(), {8, 2, 0, 0, 0}); // 8 bits, RGB, deflate, filtro adaptativo, sem entrelaçamento
+    write_png_chunk(file, "IHDR", ihdr);
+
+    size_t row_size = 3 * (size_t)fb.width;
+    std::vector<uint8_t> raw;
+    raw.reserve((row_size + 1) * fb.height);
+    std::vector<uint8_t> candidates[3];
+    for (auto& c : candidates) c.resize(row_size);
+    for (int y = 0; y < fb.height; ++y) {
+        const uint8_t *row = &fb.rgb[y * row_size];
+        const uint8_t *above = y > 0 ? row - row_size : nullptr;
+        unsigned long best_sum = 0;
+        int best_filter = 0;
+        for (int filter = 0; filter < 3; ++filter) {
+            unsigned long sum = 0;
+            for (size_t x = 0; x < row_size; ++x) {
+                uint8_t left = x >= 3 ? row[x - 3] : 0, up = above ? above[x] : 0;
+                uint8_t value = (uint8_t)(row[x] - (filter == 1 ? left : filter == 2 ? up : 0));
+                candidates[filter][x] = value;
+                sum += value < 128 ? value : 256 - value;
+            }
+            if (filter == 0 || sum < best_sum) {
+                best_sum = sum;
+                best_filter = filter;
+            }
+        }
+        raw.push_back((uint8_t)best_filter);
+        raw.insert(raw.end(), candidates[best_filter].begin(), candidates[best_filter].end());
+    }
+
+    std::vector<uint8_t> zlib = {0x78, 0x01};
+    deflate_fixed(raw, zlib);
+    uint32_t a = 1, b = 0; // Adler-32
+    for (uint8_t byte : raw) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    put_be32(zlib, (b << 16) | a);
+    write_png_chunk(file, "IDAT", zlib);
+    write_png_chunk(file, "IEND", {});
+    file.close();
+    return (bool)file;
+}
+
+} // namespace
+
+/**
+ * @brief Renderiza a geometria num arquivo de imagem, sem abrir janela.
+ *
+ * O formato é escolhido pela extensão: ".ppm" gera PPM binário, qualquer outra gera PNG.
+ * @param fill_faces Preenche as faces antes de desenhar as arestas.
+ * @param show_labels Desenha os IDs de vértices, arestas e faces, como a tecla 'l' da janela.
+ * @param max_threads Limite de threads de rasterização (0 = número de núcleos).
+ */
+bool render_offscreen(TwoDHalfEdgeGeometry& geometry, const std::string& filepath, int width, int height,
+                      bool fill_faces, bool show_labels, unsigned int max_threads)
+{
+    if (width <= 0 || height <= 0) {
+        std::cerr << "Erro: Tamanho de imagem invalido." << std::endl;
+        return false;
+    }
+
+    // 1. Leva os vértices para coordenadas de pixel (y para baixo), com o enquadramento da janela.
+    ViewBounds view = compute_view_bounds(geometry);
+    double scale_x = width / (view.right - view.left), scale_y = height / (view.top - view.bottom);
+    auto to_px = [&](double x) { return (float)((x - view.left) * scale_x); };
+    auto to_py = [&](double y) { return (float)((view.top - y) * scale_y); };
+
+    std::vector<float> vx_px(geometry.get_vertex_count()), vx_py(geometry.get_vertex_count());
+    for (unsigned int v = 0; v < geometry.get_vertex_count(); ++v) {
+        auto pos = geometry.get_vertex_position(v);
+        vx_px[v] = to_px(pos.first);
+        vx_py[v] = to_py(pos.second);
+    }
+
+    // 2. Monta as primitivas. As arestas vêm das faces, que não exigem a topologia
+    // no modo preguiçoso; arestas internas aparecem duas vezes e cobrem os mesmos pixels.
+    std::vector<Triangle> triangles;
+    std::vector<Segment> segments;
+    std::vector<Label> labels;
+    geometry.for_each_face([&](unsigned int fa_id, const unsigned int *vertex_ids, size_t n_vertices) {
+        for (size_t i = 0; i < n_vertices; ++i) {
+            unsigned int a = vertex_ids[i], b = vertex_ids[(i + 1) % n_vertices];
+            segments.push_back({vx_px[a], vx_py[a], vx_px[b], vx_py[b]});
+        }
+        if (fill_faces) {
+            // Leque a partir do primeiro vértice (correto para faces convexas).
+            for (size_t i = 1; i + 1 < n_vertices; ++i) {
+                unsigned int a = vertex_ids[0], b = vertex_ids[i], c = vertex_ids[i + 1];
+                triangles.push_back({{vx_px[a], vx_px[b], vx_px[c]}, {vx_py[a], vx_py[b], vx_py[c]}});
+            }
+        }
+        if (show_labels) {
+            double cx = 0.0, cy = 0.0;
+            for (size_t i = 0; i < n_vertices; ++i) {
+                auto pos = geometry.get_vertex_position(vertex_ids[i]);
+                cx += pos.first;
+                cy += pos.second;
+            }
+            labels.push_back({to_px(cx / n_vertices), to_py(cy / n_vertices), FACE_LABEL_COLOR, "f" + std::to_string(fa_id)});
+        }
+    });
+    if (show_labels) {
+        for (unsigned int v = 0; v < geometry.get_vertex_count(); ++v) {
+            auto pos = geometry.get_vertex_position(v);
+            labels.push_back({to_px(pos.first + 0.1), to_py(pos.second + 0.1), VERTEX_LABEL_COLOR, std::to_string(v)});
+        }
+        // Como na janela, cada aresta é identificada pela half-edge que vai do menor ao maior vértice.
+        geometry.for_each_half_edge([&](unsigned int he_id, unsigned int origin, unsigned int dest, long, long) {
+            if (origin >= dest) return;
+            auto p1 = geometry.get_vertex_position(origin), p2 = geometry.get_vertex_position(dest);
+            labels.push_back({to_px((p1.first + p2.first) / 2.0 + 0.1), to_py((p1.second + p2.second) / 2.0 + 0.1),
+                              EDGE_LABEL_COLOR, std::to_string(he_id)});
+        });
+    }
+
+    // 3. Distribui as primitivas pelos blocos que suas caixas envolventes tocam.
+    int tiles_x = (width + TILE_SIZE - 1) / TILE_SIZE, tiles_y = (height + TILE_SIZE - 1) / TILE_SIZE;
+    size_t n_tiles = (size_t)tiles_x * tiles_y;
+    std::vector<std::vector<unsigned int>> tile_triangles(n_tiles), tile_segments(n_tiles), tile_labels(n_tiles);
+    auto bin = [&](std::vector<std::vector<unsigned int>>& bins, unsigned int idx, float x0, float y0, float x1, float y1) {
+        int tx0 = std::max(0, (int)std::floor(x0) / TILE_SIZE), tx1 = std::min(tiles_x - 1, (int)std::floor(x1) / TILE_SIZE);
+        int ty0 = std::max(0, (int)std::floor(y0) / TILE_SIZE), ty1 = std::min(tiles_y - 1, (int)std::floor(y1) / TILE_SIZE);
+        if (x1 < 0 || y1 < 0) return;
+        for (int ty = ty0; ty <= ty1; ++ty) {
+            for (int tx = tx0; tx <= tx1; ++tx) bins[(size_t)ty * tiles_x + tx].push_back(idx);
+        }
+    };
+    for (unsigned int i = 0; i < triangles.size(); ++i) {
+        const Triangle& t = triangles[i];
+        bin(tile_triangles, i, std::min({t.x[0], t.x[1], t.x[2]}), std::min({t.y[0], t.y[1], t.y[2]}),
+            std::max({t.x[0], t.x[1], t.x[2]}), std::max({t.y[0], t.y[1], t.y[2]}));
+    }
+    for (unsigned int i = 0; i < segments.size(); ++i) {
+        const Segment& s = segments[i];
+        bin(tile_segments, i, std::min(s.x0, s.x1) - 2, std::min(s.y0, s.y1) - 2, std::max(s.x0, s.x1) + 2, std::max(s.y0, s.y1) + 2);
+    }
+    for (unsigned int i = 0; i < labels.size(); ++i) {
+        const Label& l = labels[i];
+        bin(tile_labels, i, l.x, l.y - GLYPH_HEIGHT - 1, l.x + GLYPH_ADVANCE * l.text.size() + 1, l.y + 1);
+    }
+
+    // 4. Rasteriza: cada thread pega o próximo bloco livre e desenha faces, arestas, vértices e labels, nessa ordem.
+    Framebuffer fb{width, height, std::vector<uint8_t>(3 * (size_t)width * height)};
+    std::atomic<size_t> next_tile(0);
+    auto worker = [&]() {
+        for (size_t t = next_tile++; t < n_tiles; t = next_tile++) {
+            int tx = (int)(t % tiles_x), ty = (int)(t / tiles_x);
+            Tile tile{tx * TILE_SIZE, ty * TILE_SIZE, std::min(width, (tx + 1) * TILE_SIZE), std::min(height, (ty + 1) * TILE_SIZE)};
+
+            for (int y = tile.y0; y < tile.y1; ++y) {
+                for (int x = tile.x0; x < tile.x1; ++x) fb.set(x, y, BACKGROUND_COLOR);
+            }
+            for (unsigned int i : tile_triangles[t]) fill_triangle(fb, tile, triangles[i], FACE_COLOR);
+            for (unsigned int i : tile_segments[t]) draw_segment(fb, tile, segments[i], EDGE_COLOR);
+            for (unsigned int i : tile_segments[t]) {
+                stamp(fb, tile, segments[i].x0, segments[i].y0, 3, EDGE_COLOR);
+                stamp(fb, tile, segments[i].x1, segments[i].y1, 3, EDGE_COLOR);
+            }
+            for (unsigned int i : tile_labels[t]) draw_label(fb, tile, labels[i]);
+        }
+    };
+
+    unsigned int n_threads = max_threads ? max_threads : std::max(1u, std::thread::hardware_concurrency());
+    n_threads = (unsigned int)std::min<size_t>(n_threads, n_tiles);
+    std::vector<std::thread> pool;
+    for (unsigned int i = 1; i < n_threads; ++i) pool.emplace_back(worker);
+    worker();
+    for (auto& th : pool) th.join();
+
+    // 5. Grava a imagem.
+    bool is_ppm = filepath.size() >= 4 && filepath.compare(filepath.size() - 4, 4, ".ppm") == 0;
+    if (!(is_ppm ? write_ppm(filepath, fb) : write_png(filepath, fb))) {
+        std::cerr << "Erro: Nao foi possivel escrever a imagem: " << filepath << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -11,16 +11,34 @@
 #include <string>
 #include <sstream>
 #include <vector>
+#include <map>
 #include <cmath>
 #include <algorithm>
 
 #include "../dsa/TwoDHalfEdgeGeometry.h"
+#include "../dsa/MeshRegistry.h"
+#include "../dsa/MeshGraph.h"
+#include "framing.h"
+
+// Implementados em io/meshwriter.cpp
+bool write_obj_file(const std::string& filepath, TwoDHalfEdgeGeometry& geometry);
+bool write_ply_file(const std::string& filepath, TwoDHalfEdgeGeometry& geometry);
+// Implementado em renderer/offscreen.cpp
+bool render_offscreen(TwoDHalfEdgeGeometry& geometry, const std::string& filepath, int width, int height,
+                      bool fill_faces, bool show_labels, unsigned int max_threads);
 
 // --- Variáveis Globais para o Estado da UI e Labels ---
+MeshRegistry* g_registry = nullptr;
+// Mantém a malha exibida viva mesmo que o registro a descarregue.
+std::shared_ptr<TwoDHalfEdgeGeometry> g_geometry_ref;
 TwoDHalfEdgeGeometry* g_geometry = nullptr;
+// Grafo da malha atual, construído no primeiro comando de grafo.
+std::unique_ptr<MeshGraph> g_graph;
 std::string g_command_input = "";
 std::string g_command_output = "Digite 'ajuda' e pressione Enter. Pressione 'l' para ver os IDs.";
 bool g_show_labels = false;
+// Limite de threads do --threads, repassado aos algoritmos paralelos (0 = número de núcleos).
+unsigned int g_max_threads = 0;
 
 // --- Funções da Interface Gráfica ---
 
@@ -31,7 +49,174 @@ void render_text(float x, float y, const std::string& text) {
     }
 }
 
-void process_command() {
+/**
+ * @brief Ajusta a projeção para enquadrar a malha atual com uma margem de 10%.
+ */
+void frame_geometry() {
+    ViewBounds view = compute_view_bounds(*g_geometry);
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glOrtho(view.left, view.right, view.bottom, view.top, -1.0, 1.0);
+}
+
+/**
+ * @brief Troca a malha exibida pela malha 'mesh_id' do registro.
+ */
+void select_mesh(unsigned int mesh_id) {
+    g_geometry_ref = g_registry->select(mesh_id);
+    g_geometry = g_geometry_ref.get();
+    g_graph.reset();
+    frame_geometry();
+}
+
+/**
+ * @brief Atualiza no registro a memória da malha exibida, que cresce no modo
+ * preguiçoso conforme é consultada ou desenhada com labels.
+ */
+void refresh_selected_memory() {
+    int selected = g_registry->get_selected_id();
+    if (selected >= 0) g_registry->refresh_memory(selected);
+}
+
+/**
+ * @brief Trata os comandos do registro de malhas.
+ * @return true se 'action' era um desses comandos.
+ */
+bool process_registry_command(const std::string& action, std::istringstream& iss, std::stringstream& result_stream) {
+    if (action == "malhas") {
+        result_stream << "Malhas:";
+        for (unsigned int i = 0; i < g_registry->size(); ++i) {
+            result_stream << " " << i << (i == (unsigned int)g_registry->get_selected_id() ? "*" : "")
+                          << "=" << g_registry->get_path(i)
+                          << (g_registry->is_loaded(i) ? "" : "(descarregada)");
+        }
+    } else if (action == "memoria") {
+        const double mb = 1024.0 * 1024.0;
+        result_stream.precision(2);
+        result_stream << std::fixed << "Memoria:";
+        for (unsigned int i = 0; i < g_registry->size(); ++i) {
+            if (g_registry->is_loaded(i)) result_stream << " " << i << "=" << g_registry->get_mesh_memory(i) / mb << "MB";
+        }
+        result_stream << " | total " << g_registry->get_total_memory() / mb << "MB";
+        if (g_registry->get_memory_budget() != 0) result_stream << " de " << g_registry->get_memory_budget() / mb << "MB";
+    } else if (action == "selecionar") {
+        int id;
+        if (!(iss >> id) || id < 0) {
+            result_stream << "Erro: ID da malha ausente. Ex: 'selecionar 1'";
+            return true;
+        }
+        try {
+            select_mesh(id);
+            result_stream << "Malha " << id << " selecionada: " << g_registry->get_path(id);
+        } catch (const std::out_of_range&) {
+            result_stream << "Erro: A malha " << id << " nao existe.";
+        } catch (const std::exception& e) {
+            result_stream << "Erro: " << e.what();
+        }
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Escreve até 'max_items' IDs de uma lista, indicando quantos ficaram de fora.
+ */
+void write_id_list(std::stringstream& result_stream, const std::vector<unsigned int>& ids, size_t max_items = 40) {
+    for (size_t i = 0; i < ids.size() && i < max_items; ++i) result_stream << ids[i] << " ";
+    if (ids.size() > max_items) result_stream << "... (+" << ids.size() - max_items << ")";
+}
+
+/**
+ * @brief Trata os comandos de algoritmos de grafo sobre a malha atual.
+ * @return true se 'action' era um desses comandos.
+ */
+bool process_graph_command(const std::string& action, std::istringstream& iss, std::stringstream& result_stream) {
+    if (action != "componentes" && action != "flood_fill" && action != "distancia_faces" &&
+        action != "caminho_minimo" && action != "caminho_dijkstra") {
+        return false;
+    }
+
+    int a = 0, b = 0;
+    if (action == "flood_fill" && !(iss >> a)) {
+        result_stream << "Erro: ID da face ausente. Ex: 'flood_fill 0'";
+        return true;
+    }
+    if ((action == "distancia_faces" || action == "caminho_minimo" || action == "caminho_dijkstra") && !(iss >> a >> b)) {
+        result_stream << "Erro: Informe dois IDs. Ex: '" << action << " 0 5'";
+        return true;
+    }
+    if (a < 0 || b < 0) {
+        result_stream << "Erro: IDs devem ser positivos.";
+        return true;
+    }
+
+    if (!g_graph) g_graph = std::make_unique<MeshGraph>(*g_geometry, g_max_threads);
+
+    try {
+        if (action == "componentes") {
+            std::vector<unsigned int> labels;
+            unsigned int n = g_graph->connected_components(labels);
+            result_stream << n << " componente(s) conexa(s). Menor vertice de cada uma: ";
+            std::vector<unsigned int> roots;
+            for (unsigned int v = 0; v < labels.size(); ++v) {
+                if (labels[v] == v) roots.push_back(v);
+            }
+            write_id_list(result_stream, roots);
+        } else if (action == "flood_fill") {
+            auto region = g_graph->flood_fill(a);
+            result_stream << region.size() << " face(s) alcancaveis a partir da face " << a << ": ";
+            write_id_list(result_stream, region);
+        } else if (action == "distancia_faces") {
+            auto dist = g_graph->face_bfs(a);
+            if (b >= (int)dist.size()) throw std::out_of_range("face");
+            if (dist[b] < 0) result_stream << "A face " << b << " nao e alcancavel a partir da face " << a << ".";
+            else result_stream << "Distancia entre as faces " << a << " e " << b << ": " << dist[b] << " salto(s).";
+        } else {
+            auto path = action == "caminho_minimo" ? g_graph->a_star(a, b) : g_graph->dijkstra(a, b);
+            if (!path.found) {
+                result_stream << "Nao ha caminho entre os vertices " << a << " e " << b << ".";
+            } else {
+                result_stream << "Caminho (comprimento " << path.length << "): vertices ";
+                write_id_list(result_stream, path.vertices);
+                result_stream << "| arestas ";
+                write_id_list(result_stream, path.edges);
+            }
+        }
+    } catch (const std::out_of_range&) {
+        result_stream << "Erro: ID nao encontrado.";
+    }
+    return true;
+}
+
+/**
+ * @brief Trata os comandos de exportação da malha atual (arquivos de malha e imagem).
+ * @return true se 'action' era um desses comandos.
+ */
+bool process_export_command(const std::string& action, std::istringstream& iss, std::stringstream& result_stream) {
+    if (action != "exportar_obj" && action != "exportar_ply" && action != "salvar_imagem") return false;
+
+    std::string filepath;
+    if (!(iss >> filepath)) {
+        result_stream << "Erro: Caminho ausente. Ex: '" << action << " <arquivo>'";
+        return true;
+    }
+
+    bool ok;
+    if (action == "salvar_imagem") {
+        // Mesmo tamanho e labels que a janela mostra agora.
+        ok = render_offscreen(*g_geometry, filepath, glutGet(GLUT_WINDOW_WIDTH), glutGet(GLUT_WINDOW_HEIGHT),
+                              false, g_show_labels, g_max_threads);
+    } else {
+        ok = action == "exportar_obj" ? write_obj_file(filepath, *g_geometry) : write_ply_file(filepath, *g_geometry);
+    }
+    if (!ok) result_stream << "Erro: Nao foi possivel escrever " << filepath;
+    else if (action == "salvar_imagem") result_stream << "Imagem salva em " << filepath;
+    else result_stream << "Malha exportada para " << filepath;
+    return true;
+}
+
+void process_command_line() {
     if (g_command_input.empty()) return;
     std::stringstream result_stream;
     std::istringstream iss(g_command_input);
@@ -39,7 +224,15 @@ void process_command() {
     iss >> action;
 
     if (action == "ajuda") {
-        g_command_output = "Comandos: faces_adjacentes_face/aresta <id>, faces/arestas_do_vertice <id>";
+        g_command_output = "Comandos: faces_adjacentes_face/aresta <id>, faces/arestas_do_vertice <id>, malhas, selecionar <id>, memoria, componentes, flood_fill <face>, distancia_faces <a> <b>, caminho_minimo/caminho_dijkstra <vx_a> <vx_b>, exportar_obj/exportar_ply/salvar_imagem <arquivo>";
+        g_command_input.clear();
+        return;
+    }
+
+    if (process_registry_command(action, iss, result_stream) ||
+        process_graph_command(action, iss, result_stream) ||
+        process_export_command(action, iss, result_stream)) {
+        g_command_output = result_stream.str();
         g_command_input.clear();
         return;
     }
@@ -79,6 +272,16 @@ void process_command() {
     g_command_input.clear();
 }
 
+/**
+ * @brief Executa o comando digitado e atualiza a memória da malha, que ele pode ter feito crescer.
+ */
+void process_command() {
+    if (g_command_input.empty()) return;
+    refresh_selected_memory(); // 'memoria' deve ver o que os quadros já desenhados construíram.
+    process_command_line();
+    refresh_selected_memory();
+}
+
 
 // --- Funções de Callback do OpenGL ---
 
@@ -89,24 +292,39 @@ void display() {
     
     if (g_geometry) {
         auto vertices = g_geometry->get_vertexes();
-        auto edges = g_geometry->get_vxs_conn_edges_id();
+
+        // No modo preguiçoso, sem labels, as arestas saem das listas das faces: assim
+        // desenhar não monta a topologia inteira (arestas internas são desenhadas duas vezes).
+        bool edges_from_faces = g_geometry->is_lazy() && !g_show_labels;
+        std::map<std::pair<unsigned int, unsigned int>, unsigned int> edges;
+        if (!edges_from_faces) edges = g_geometry->get_vxs_conn_edges_id();
+
+        auto draw_edge = [](const std::pair<double, double>& pos1, const std::pair<double, double>& pos2) {
+            const int num_steps = 100;
+            double dx = pos2.first - pos1.first;
+            double dy = pos2.second - pos1.second;
+            for (int i = 0; i <= num_steps; ++i) {
+                double t = static_cast<double>(i) / num_steps;
+                glVertex2d(pos1.first + t * dx, pos1.second + t * dy);
+            }
+        };
 
         glColor3f(1.0f, 1.0f, 1.0f);
-        if (!vertices.empty() && !edges.empty()) {
+        if (!vertices.empty()) {
             glPointSize(2.0f);
             glBegin(GL_POINTS);
-            for (const auto& [vertex_pair, edge_id] : edges) {
-                try {
-                    const auto& pos1 = vertices.at(vertex_pair.first);
-                    const auto& pos2 = vertices.at(vertex_pair.second);
-                    const int num_steps = 100;
-                    double dx = pos2.first - pos1.first;
-                    double dy = pos2.second - pos1.second;
-                    for (int i = 0; i <= num_steps; ++i) {
-                        double t = static_cast<double>(i) / num_steps;
-                        glVertex2d(pos1.first + t * dx, pos1.second + t * dy);
+            if (edges_from_faces) {
+                g_geometry->for_each_face([&](unsigned int, const unsigned int *vertex_ids, size_t n_vertices) {
+                    for (size_t i = 0; i < n_vertices; ++i) {
+                        draw_edge(vertices.at(vertex_ids[i]), vertices.at(vertex_ids[(i + 1) % n_vertices]));
                     }
-                } catch(const std::out_of_range&) {}
+                });
+            } else {
+                for (const auto& [vertex_pair, edge_id] : edges) {
+                    try {
+                        draw_edge(vertices.at(vertex_pair.first), vertices.at(vertex_pair.second));
+                    } catch(const std::out_of_range&) {}
+                }
             }
             glEnd();
         }
@@ -148,6 +366,9 @@ void display() {
                 centroidY /= vertex_ids.size();
                 render_text(centroidX, centroidY, "f" + std::to_string(face_id));
             }
+
+            // Os labels montam a topologia de uma malha preguiçosa.
+            if (g_geometry->is_lazy()) refresh_selected_memory();
         }
     }
 
@@ -192,33 +413,17 @@ void keyboard(unsigned char key, int x, int y) {
 }
 
 
-void start_renderer(int argc, char* argv[], TwoDHalfEdgeGeometry& geometry) {
+void start_renderer(int argc, char* argv[], MeshRegistry& registry, unsigned int max_threads) {
     glutInit(&argc, argv);
     glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB | GLUT_ALPHA);
     glutInitWindowSize(800, 600);
     glutCreateWindow("Visualizador Interativo .obj");
 
-    g_geometry = &geometry;
-
-    auto vertices = g_geometry->get_vertexes();
-    double minX = 0, maxX = 0, minY = 0, maxY = 0;
-    if (!vertices.empty()) {
-        minX = maxX = vertices.begin()->second.first;
-        minY = maxY = vertices.begin()->second.second;
-        for (const auto& [id, pos] : vertices) {
-            minX = std::min(minX, pos.first);
-            maxX = std::max(maxX, pos.first);
-            minY = std::min(minY, pos.second);
-            maxY = std::max(maxY, pos.second);
-        }
-    }
-    
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    double paddingX = (maxX - minX) * 0.1;
-    double paddingY = (maxY - minY) * 0.1;
-    double padding = std::max({1.0, paddingX, paddingY});
-    glOrtho(minX - padding, maxX + padding, minY - padding, maxY + padding, -1.0, 1.0);
+    g_registry = &registry;
+    g_max_threads = max_threads;
+    g_geometry_ref = registry.get_selected();
+    g_geometry = g_geometry_ref.get();
+    frame_geometry();
     
     glutDisplayFunc(display);
     glutKeyboardFunc(keyboard);